@@ -4,6 +4,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+// label column width with sink row only and when per-stream rows are shown
+#define DLG_SINK_LABEL_WIDTH 40
+#define DLG_STREAM_LABEL_WIDTH 100
+
 typedef struct dlg_geometry {
   int32_t width;
   int32_t heigth;
@@ -12,6 +16,7 @@ typedef struct dlg_geometry {
 } dlg_geometry_t;
 
 int dlg_open(int64_t vol, const dlg_geometry_t *di);
+int dlg_resize(const dlg_geometry_t *di);
 int dlg_tick(void);
 void dlg_close(void);
 
@@ -0,0 +1,29 @@
+#ifndef DLG_BACKEND_H
+#define DLG_BACKEND_H
+
+#include "dlg.h"
+
+#include <microui.h>
+#include <stdbool.h>
+
+// what backend collected since previous frame
+typedef struct dlg_input {
+  int mouse_x, mouse_y;
+  int mouse_down; // MU_MOUSE_* mask of buttons which are down now
+  int vol_delta;  // hjkl and arrows: +1 up, -1 down
+  bool should_close;
+} dlg_input_t;
+
+// implemented by exactly one of src/dlg_raylib.c or src/dlg_x11.c,
+// see VOLUMECTL_DLG_BACKEND in CMakeLists.txt
+const char *dlg_backend_name(void);
+int dlg_backend_open(const dlg_geometry_t *di);
+void dlg_backend_resize(const dlg_geometry_t *di);
+void dlg_backend_close(void);
+void dlg_backend_input(dlg_input_t *in);
+void dlg_backend_render(mu_Context *ctx);
+
+int dlg_backend_text_width(const char *txt, int len);
+int dlg_backend_text_height(void);
+
+#endif /* DLG_BACKEND_H */
@@ -0,0 +1,33 @@
+#ifndef STREAMS_H
+#define STREAMS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define STREAMS_MAX 32
+// short on purpose: label column in the dialog is narrow
+#define STREAM_NAME_LEN 10
+
+// playback stream (sink-input) cache entry, keyed by pa index
+typedef struct stream {
+  bool used;
+  uint32_t idx;
+  uint32_t sink_idx;
+  uint8_t channels;
+  int32_t vol;  // last known (or last written) volume in percents
+  float slider; // dialog slider value
+  char name[STREAM_NAME_LEN];
+} stream_t;
+
+stream_t *streams_get(uint32_t idx);
+stream_t *streams_put(uint32_t idx);
+void streams_remove(uint32_t idx);
+void streams_clear(void);
+
+// only streams which belong to this sink are visible for count/next
+void streams_set_sink(uint32_t sink_idx);
+size_t streams_count(void);
+stream_t *streams_next(stream_t *it);
+
+#endif /* STREAMS_H */
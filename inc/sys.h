@@ -1,9 +1,11 @@
 #ifndef SYS_H
 #define SYS_H
 
+#include <stdint.h>
 #include <unistd.h>
 
 int sys_read(int fd, void *buf, size_t size, size_t *count);
 int sys_cloexec(int fd);
+uint64_t sys_now_usec(void);
 
 #endif /* SYS_H */
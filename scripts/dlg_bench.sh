@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+# Builds volumectl with each dialog backend and opens the popup once under
+# Xvfb. Prints the dlg timing line (open latency, frames, avg frame cost).
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BACKENDS="${BACKENDS:-raylib x11}"
+RUN_SEC="${RUN_SEC:-3}"
+CLICK='{"x": 100, "y": 20, "relative_x": 10, "relative_y": 8, "width": 80, "height": 20}'
+
+if ! command -v xvfb-run >/dev/null; then
+  echo "xvfb-run not found" >&2
+  exit 1
+fi
+
+for be in ${BACKENDS}; do
+  BUILD_DIR="${ROOT_DIR}/build-bench-${be}"
+  cmake -S "${ROOT_DIR}" -B "${BUILD_DIR}" -DCMAKE_BUILD_TYPE=Release \
+    -DVOLUMECTL_DLG_BACKEND="${be}" -DVOLUMECTL_DLG_BENCH=ON >/dev/null
+  cmake --build "${BUILD_DIR}" >/dev/null
+
+  # stdin stays open while dialog runs, SIGTERM closes it and prints timings
+  { echo "${CLICK}"; sleep "$((RUN_SEC + 1))"; } |
+    xvfb-run -a -s "-screen 0 1280x720x24" \
+      timeout -s TERM "${RUN_SEC}" "${BUILD_DIR}/volumectl" 2>&1 >/dev/null |
+    grep -a 'dlg\[' || echo "${be}: no timing output" >&2
+done
@@ -0,0 +1,67 @@
+#!/usr/bin/env bash
+# Two stage PGO build on top of LTO, then runs scripts/pgo_train.sh against
+# the LTO-only and the LTO+PGO binaries and prints averaged dlg timings and
+# event path (sink, sink-input, click) timings.
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BACKEND="${BACKEND:-raylib}"
+BASE_DIR="${ROOT_DIR}/build-lto"
+PGO_DIR="${ROOT_DIR}/build-pgo"
+PROF_DIR="${PGO_DIR}/profiles"
+XVFB=(xvfb-run -a -s "-screen 0 1280x720x24")
+
+COMMON=(-DCMAKE_BUILD_TYPE=Release -DVOLUMECTL_DLG_BACKEND="${BACKEND}"
+  -DVOLUMECTL_LTO=ON)
+
+echo "== baseline: LTO"
+cmake -S "${ROOT_DIR}" -B "${BASE_DIR}" "${COMMON[@]}" -DVOLUMECTL_PGO=OFF \
+  >/dev/null
+cmake --build "${BASE_DIR}" >/dev/null
+
+echo "== stage 1: instrumented build + training"
+rm -rf "${PROF_DIR}"
+cmake -S "${ROOT_DIR}" -B "${PGO_DIR}" "${COMMON[@]}" \
+  -DVOLUMECTL_PGO=GENERATE -DVOLUMECTL_PGO_DIR="${PROF_DIR}" >/dev/null
+cmake --build "${PGO_DIR}" >/dev/null
+"${XVFB[@]}" "${ROOT_DIR}/scripts/pgo_train.sh" "${PGO_DIR}/volumectl" \
+  >/dev/null
+
+# clang writes raw profiles which have to be merged, gcc .gcda are used as is
+shopt -s nullglob
+RAW=("${PROF_DIR}"/*.profraw)
+GCDA=("${PROF_DIR}"/*.gcda)
+if ((${#RAW[@]})); then
+  llvm-profdata merge -output="${PROF_DIR}/volumectl.profdata" "${RAW[@]}"
+elif ((!${#GCDA[@]})); then
+  # otherwise stage 2 silently builds without profile and the report lies
+  echo "no profiles in ${PROF_DIR}, training run failed?" >&2
+  exit 1
+fi
+
+echo "== stage 2: optimised build"
+cmake -S "${ROOT_DIR}" -B "${PGO_DIR}" "${COMMON[@]}" -DVOLUMECTL_PGO=USE \
+  >/dev/null
+cmake --build "${PGO_DIR}" >/dev/null
+
+# dlg[be]: open X ms, N frames, avg frame Y ms
+# events: sink N avg X us, sink-input N avg Y us, click N avg Z us
+report() {
+  awk -v name="$1" '/dlg\[/ {
+    n++; open += $3; frames += $5; work += $9 * $5
+  } /events:/ {
+    ev = sprintf("sink %d avg %.3f us, sink-input %d avg %.3f us, " \
+                 "click %d avg %.3f us", $3, $5, $8, $10, $13, $15)
+  } END {
+    if (!n || ev == "") { print name ": no timing output"; exit 1 }
+    printf "%-8s dialogs %d, avg open %.3f ms, avg frame %.4f ms\n",
+           name, n, open / n, frames ? work / frames : 0
+    printf "%-8s events: %s\n", name, ev
+  }'
+}
+
+echo "== results (${BACKEND})"
+"${XVFB[@]}" "${ROOT_DIR}/scripts/pgo_train.sh" "${BASE_DIR}/volumectl" |
+  report "lto"
+"${XVFB[@]}" "${ROOT_DIR}/scripts/pgo_train.sh" "${PGO_DIR}/volumectl" |
+  report "lto+pgo"
@@ -0,0 +1,90 @@
+#!/usr/bin/env bash
+# Headless PGO training / benchmark workload. Run under Xvfb, e.g.
+#   xvfb-run -a -s "-screen 0 1280x720x24" scripts/pgo_train.sh build/volumectl
+# Starts a private audio server with a null sink and one playback stream,
+# then replays clicks, drags the slider, presses keys and storms the sink
+# with volume changes. Prints dlg and events timing lines of volumectl to
+# stdout.
+set -euo pipefail
+
+BIN="${1:?usage: $0 path/to/volumectl}"
+ROUNDS="${ROUNDS:-20}"
+STORM="${STORM:-500}"
+# panel on top, dialog opens at (50, 20)
+CLICK='{"x": 100, "y": 10, "relative_x": 10, "relative_y": 10, "width": 80, "height": 20}'
+
+for tool in pulseaudio pactl pacat xdotool; do
+  if ! command -v "${tool}" >/dev/null; then
+    echo "${tool} not found" >&2
+    exit 1
+  fi
+done
+if [[ -z "${DISPLAY:-}" ]]; then
+  echo "DISPLAY is not set, run under xvfb-run" >&2
+  exit 1
+fi
+
+TMP_DIR="$(mktemp -d)"
+PIDS=()
+cleanup() {
+  for pid in "${PIDS[@]}"; do
+    kill "${pid}" 2>/dev/null || true
+  done
+  wait 2>/dev/null || true
+  rm -rf "${TMP_DIR}"
+}
+trap cleanup EXIT
+
+# private server, so training never touches the real one
+export PULSE_RUNTIME_PATH="${TMP_DIR}/pulse"
+export PULSE_SERVER="unix:${TMP_DIR}/pulse.sock"
+pulseaudio -n --daemonize=no --exit-idle-time=-1 --disable-shm=yes \
+  -L module-null-sink \
+  -L "module-native-protocol-unix socket=${TMP_DIR}/pulse.sock" \
+  >/dev/null 2>&1 &
+PIDS+=($!)
+for _ in $(seq 1 50); do
+  pactl info >/dev/null 2>&1 && break
+  sleep 0.1
+done
+
+# one sink input, so per-stream rows are exercised too
+pacat --playback </dev/zero &
+PIDS+=($!)
+
+mkfifo "${TMP_DIR}/stdin"
+"${BIN}" <"${TMP_DIR}/stdin" >/dev/null 2>"${TMP_DIR}/stderr" &
+VC_PID=$!
+exec 3>"${TMP_DIR}/stdin"
+
+# sink event storm in background
+(
+  for i in $(seq 1 "${STORM}"); do
+    pactl set-sink-volume @DEFAULT_SINK@ "$((i % 100))%"
+  done
+) &
+PIDS+=($!)
+
+for _ in $(seq 1 "${ROUNDS}"); do
+  echo "${CLICK}" >&3
+  WIN="$(xdotool search --sync --limit 1 --name '^volumectl$')"
+
+  # scripted slider drag along the first row
+  xdotool mousemove --window "${WIN}" 60 10 mousedown 1
+  for x in $(seq 60 10 220); do
+    xdotool mousemove --window "${WIN}" "${x}" 10
+  done
+  xdotool mouseup 1
+
+  xdotool key --window "${WIN}" k l Up Right j h Down Left
+  xdotool key --window "${WIN}" Escape
+  while xdotool search --name '^volumectl$' >/dev/null 2>&1; do
+    sleep 0.05
+  done
+done
+
+# SIGTERM is handled, so profile data is written on normal exit
+exec 3>&-
+kill -TERM "${VC_PID}"
+wait "${VC_PID}" || true
+grep -a -E 'dlg\[|events:' "${TMP_DIR}/stderr" | sed 's/^<[0-9]>//'
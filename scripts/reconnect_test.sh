@@ -0,0 +1,109 @@
+#!/usr/bin/env bash
+# Reconnect check against a private stand-in audio server:
+# start server, run volumectl, kill and restart the server, then make sure
+# it is the same volumectl process and the status line comes back.
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="${BUILD_DIR:-${ROOT_DIR}/build}"
+BIN="${1:-${BUILD_DIR}/volumectl}"
+# reconnect backoff is 100 ms .. 10 s, so this covers several attempts
+RECOVER_SEC="${RECOVER_SEC:-15}"
+DOWN_SEC="${DOWN_SEC:-2}"
+
+if [[ ! -x "${BIN}" ]]; then
+  echo "Binary not found or not executable: ${BIN}" >&2
+  exit 1
+fi
+for tool in pulseaudio pactl; do
+  if ! command -v "${tool}" >/dev/null; then
+    echo "${tool} not found" >&2
+    exit 1
+  fi
+done
+
+TMP_DIR="$(mktemp -d)"
+PA_PID=""
+VC_PID=""
+cleanup() {
+  for pid in ${VC_PID} ${PA_PID}; do
+    kill "${pid}" 2>/dev/null || true
+  done
+  wait 2>/dev/null || true
+  rm -rf "${TMP_DIR}"
+}
+trap cleanup EXIT
+
+export PULSE_RUNTIME_PATH="${TMP_DIR}/pulse"
+export PULSE_SERVER="unix:${TMP_DIR}/pulse.sock"
+
+start_server() {
+  rm -f "${TMP_DIR}/pulse.sock"
+  pulseaudio -n --daemonize=no --exit-idle-time=-1 --disable-shm=yes \
+    -L module-null-sink \
+    -L "module-native-protocol-unix socket=${TMP_DIR}/pulse.sock" \
+    >/dev/null 2>&1 &
+  PA_PID=$!
+  for _ in $(seq 1 50); do
+    pactl info >/dev/null 2>&1 && return 0
+    sleep 0.1
+  done
+  echo "FAIL: stand-in server did not start" >&2
+  exit 1
+}
+
+# wait till stdout has more than $1 status lines
+wait_status_lines() {
+  local deadline=$((SECONDS + RECOVER_SEC))
+  while ((SECONDS < deadline)); do
+    if (($(grep -c full_text "${TMP_DIR}/stdout" || true) > $1)); then
+      return 0
+    fi
+    sleep 0.1
+  done
+  return 1
+}
+
+start_server
+
+# stdin stays open, as under i3blocks
+mkfifo "${TMP_DIR}/stdin"
+"${BIN}" <"${TMP_DIR}/stdin" >"${TMP_DIR}/stdout" 2>"${TMP_DIR}/stderr" &
+VC_PID=$!
+exec 3>"${TMP_DIR}/stdin"
+
+if ! wait_status_lines 0; then
+  echo "FAIL: no initial status line" >&2
+  exit 1
+fi
+echo "initial: $(tail -n1 "${TMP_DIR}/stdout")"
+
+kill -KILL "${PA_PID}"
+wait "${PA_PID}" 2>/dev/null || true
+PA_PID=""
+sleep "${DOWN_SEC}"
+
+if ! kill -0 "${VC_PID}" 2>/dev/null; then
+  echo "FAIL: volumectl exited while server was down" >&2
+  exit 1
+fi
+LINES_BEFORE="$(grep -c full_text "${TMP_DIR}/stdout" || true)"
+
+start_server
+# change volume, so the status line after reconnect is a fresh one
+pactl set-sink-volume @DEFAULT_SINK@ 42%
+
+if ! wait_status_lines "${LINES_BEFORE}"; then
+  echo "FAIL: status line did not come back in ${RECOVER_SEC}s" >&2
+  exit 1
+fi
+if ! kill -0 "${VC_PID}" 2>/dev/null; then
+  echo "FAIL: volumectl was restarted" >&2
+  exit 1
+fi
+echo "after restart: $(tail -n1 "${TMP_DIR}/stdout")"
+grep -q '42%' "${TMP_DIR}/stdout" || {
+  echo "FAIL: volume change after reconnect was not reported" >&2
+  exit 1
+}
+echo "OK: same process (pid ${VC_PID}), reconnected"
@@ -1,20 +1,21 @@
 #include "dlg.h"
+#include "dlg_backend.h"
 #include "log.h"
+#include "streams.h"
+#include "sys.h"
 #include <microui.h>
-#include <raylib.h>
+#include <time.h>
 
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 
-#define FONT_SIZE 20
-
 static int text_width(mu_Font font, const char *txt, int len) {
   (void)font;
-  return MeasureText(TextFormat("%.*s", len, txt), FONT_SIZE);
+  return dlg_backend_text_width(txt, len);
 }
 static int text_height(mu_Font font) {
   (void)font;
-  return FONT_SIZE;
+  return dlg_backend_text_height();
 }
 
 static volatile bool g_open = false;
@@ -26,6 +27,17 @@ static float g_slider_prev = 0.0f;
 #define IDLE_TIMEOUT 5.0f
 static float g_idle = 0.0f;
 
+// 60 FPS, the same pacing for every backend
+#define FRAME_USEC (1000000 / 60)
+static uint64_t g_last_tick_usec = 0;
+
+// timings, printed on close. open is from dlg_open till first frame is
+// rendered, frame time is work only, without pacing sleep
+static uint64_t g_open_start_usec = 0;
+static uint64_t g_open_usec = 0;
+static uint64_t g_frames_usec = 0;
+static uint32_t g_frames = 0;
+
 static dlg_geometry_t g_di = {0};
 
 int dlg_open(int64_t vol, const dlg_geometry_t *di) {
@@ -33,23 +45,40 @@ int dlg_open(int64_t vol, const dlg_geometry_t *di) {
     return 0;
   }
 
+  g_open_start_usec = sys_now_usec();
   g_di = *di;
   g_idle = 0.0f;
   g_slider_curr = (float)vol;
   g_slider_prev = g_slider_curr;
+  for (stream_t *s = streams_next(NULL); s; s = streams_next(s)) {
+    s->slider = (float)s->vol;
+  }
 
   mu_init(&g_ctx);
   g_ctx.text_height = text_height;
   g_ctx.text_width = text_width;
 
-  // I don't want any logs in STDOUT because use it in i3blocks env
-  SetTraceLogLevel(LOG_NONE);
-  SetTargetFPS(60);
-  SetConfigFlags(FLAG_WINDOW_UNDECORATED | FLAG_VSYNC_HINT);
-  InitWindow(g_di.width, g_di.heigth, "volumectl");
-  SetWindowPosition(g_di.pos_x, g_di.pos_y);
+  if (dlg_backend_open(&g_di)) {
+    log_error("dlg_backend_open failed: %s\n", dlg_backend_name());
+    return -1;
+  }
 
   g_open = true;
+  g_last_tick_usec = sys_now_usec();
+  g_open_usec = 0;
+  g_frames_usec = 0;
+  g_frames = 0;
+  return 0;
+}
+//////////////////////////////////////////////////////////////
+
+int dlg_resize(const dlg_geometry_t *di) {
+  if (!g_open || !di) {
+    return 0;
+  }
+
+  g_di = *di;
+  dlg_backend_resize(&g_di);
   return 0;
 }
 //////////////////////////////////////////////////////////////
@@ -59,47 +88,30 @@ int dlg_tick(void) {
     return 0;
   }
 
-  if (WindowShouldClose()) {
+  uint64_t t0 = sys_now_usec();
+  dlg_input_t in = {0};
+  dlg_backend_input(&in);
+  if (in.should_close) {
     dlg_close();
     return 0;
   }
 
-  Vector2 mp = GetMousePosition();
-  BeginDrawing();
-
   bool input_event_happened = false;
   // mu_input functions
-  // MOUSE_BUTTON_LEFT = 0 and MU_MOUSE_LEFT = (1 << 0)
-  // MOUSE_BUTTON_RIGHT = 1 and MU_MOUSE_RIGHT = (1 << 1)
-  // MOUSE_BUTTON_MIDDLE = 2 and MU_MOUSE_MIDDLE = (1 << 2)
-  mu_input_mousemove(&g_ctx, mp.x, mp.y);
-  for (int btn = MOUSE_BUTTON_LEFT; btn <= MOUSE_BUTTON_MIDDLE; ++btn) {
-    if (IsMouseButtonDown(btn)) {
-      mu_input_mousedown(&g_ctx, mp.x, mp.y, 1 << btn);
+  mu_input_mousemove(&g_ctx, in.mouse_x, in.mouse_y);
+  for (int btn = MU_MOUSE_LEFT; btn <= MU_MOUSE_MIDDLE; btn <<= 1) {
+    if (in.mouse_down & btn) {
+      mu_input_mousedown(&g_ctx, in.mouse_x, in.mouse_y, btn);
       input_event_happened = true;
-    }
-    if (IsMouseButtonUp(btn)) {
-      mu_input_mouseup(&g_ctx, mp.x, mp.y, 1 << btn);
+    } else {
+      mu_input_mouseup(&g_ctx, in.mouse_x, in.mouse_y, btn);
     }
   }
 
   // keys
-  const KeyboardKey keys_vol_up[] = {KEY_K, KEY_L, KEY_UP, KEY_RIGHT, KEY_NULL};
-  const KeyboardKey keys_vol_down[] = {KEY_J, KEY_H, KEY_DOWN, KEY_LEFT,
-                                       KEY_NULL};
-  for (const KeyboardKey *pk = keys_vol_up; *pk != KEY_NULL; ++pk) {
-    if (IsKeyPressed(*pk)) {
-      ++g_slider_curr;
-      input_event_happened = true;
-      break;
-    }
-  }
-  for (const KeyboardKey *pk = keys_vol_down; *pk != KEY_NULL; ++pk) {
-    if (IsKeyPressed(*pk)) {
-      --g_slider_curr;
-      input_event_happened = true;
-      break;
-    }
+  if (in.vol_delta) {
+    g_slider_curr += in.vol_delta;
+    input_event_happened = true;
   }
 
   g_slider_curr = MIN(MAX(g_slider_curr, 0),
@@ -116,41 +128,49 @@ int dlg_tick(void) {
     return 0;
   }
 
-  mu_layout_row(&g_ctx, 2, (int[]){40, -1}, -1);
+  // first row is sink volume, then one row per stream on that sink
+  int rows = 1 + (int)streams_count();
+  int row_h = (g_di.heigth - g_ctx.style->padding * 2) / rows -
+              g_ctx.style->spacing;
+  int label_w = rows == 1 ? DLG_SINK_LABEL_WIDTH : DLG_STREAM_LABEL_WIDTH;
+  mu_layout_row(&g_ctx, 2, (int[]){label_w, -1}, rows == 1 ? -1 : row_h);
   mu_label(&g_ctx, "vol: ");
   mu_slider_ex(&g_ctx, &g_slider_curr, 0.0f, 100.f, 1.0f, "%.1f%%",
                MU_OPT_EXPANDED | MU_OPT_ALIGNCENTER);
 
+  for (stream_t *s = streams_next(NULL); s; s = streams_next(s)) {
+    mu_layout_row(&g_ctx, 2, (int[]){label_w, -1}, row_h);
+    mu_label(&g_ctx, s->name);
+    if (mu_slider_ex(&g_ctx, &s->slider, 0.0f, 100.f, 1.0f, "%.1f%%",
+                     MU_OPT_EXPANDED | MU_OPT_ALIGNCENTER)) {
+      input_event_happened = true;
+    }
+  }
+
   mu_end_window(&g_ctx);
   mu_end(&g_ctx);
   // !process ui end
 
-  // process commands
-  mu_Command *cmd = NULL;
-  while (mu_next_command(&g_ctx, &cmd)) {
-    switch (cmd->type) {
-    case MU_COMMAND_RECT: {
-      DrawRectangle(cmd->rect.rect.x, cmd->rect.rect.y, cmd->rect.rect.w,
-                    cmd->rect.rect.h, *(Color *)&cmd->rect.color);
-    } break;
-    case MU_COMMAND_TEXT: {
-      DrawText(cmd->text.str, cmd->text.pos.x, cmd->text.pos.y, FONT_SIZE,
-               *(Color *)&cmd->text.color);
-    } break;
-    } // switch (cmd->type)
-  } // while(mu_next_command(ctx, &cmd)
-  // !process commands end
+  dlg_backend_render(&g_ctx);
 
   if (g_slider_prev != g_slider_curr) {
     g_slider_prev = g_slider_curr;
   }
 
-  // actually we don't need it
-  Color rai_background = {.r = 0, .g = 0, .b = 0, .a = 0};
-  ClearBackground(rai_background);
-  EndDrawing();
+  uint64_t now = sys_now_usec();
+  if (g_frames == 0) {
+    g_open_usec = now - g_open_start_usec;
+  }
+  g_frames_usec += now - t0;
+  ++g_frames;
+  if (now - t0 < FRAME_USEC) {
+    uint64_t rest = FRAME_USEC - (now - t0);
+    struct timespec ts = {.tv_sec = 0, .tv_nsec = (long)rest * 1000};
+    nanosleep(&ts, NULL);
+  }
 
-  g_idle += GetFrameTime() * (!input_event_happened);
+  g_idle += (t0 - g_last_tick_usec) / 1e6f * (!input_event_happened);
+  g_last_tick_usec = t0;
   if (g_idle >= IDLE_TIMEOUT) {
     dlg_close();
   }
@@ -164,8 +184,12 @@ void dlg_close(void) {
     return;
   }
   g_idle = 0.0f;
-  CloseWindow();
+  dlg_backend_close();
   g_open = false;
+
+  log_trace("dlg[%s]: open %.3f ms, %u frames, avg frame %.3f ms\n",
+            dlg_backend_name(), g_open_usec / 1e3, g_frames,
+            g_frames ? g_frames_usec / 1e3 / g_frames : 0.0);
 }
 //////////////////////////////////////////////////////////////
 
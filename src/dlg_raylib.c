@@ -0,0 +1,102 @@
+#include "dlg_backend.h"
+#include <microui.h>
+#include <raylib.h>
+#include <stddef.h>
+
+#define FONT_SIZE 20
+
+const char *dlg_backend_name(void) { return "raylib"; }
+//////////////////////////////////////////////////////////////
+
+int dlg_backend_open(const dlg_geometry_t *di) {
+  // I don't want any logs in STDOUT because use it in i3blocks env
+  SetTraceLogLevel(LOG_NONE);
+  // no SetTargetFPS: frames are paced in dlg_tick for every backend
+#ifdef VOLUMECTL_DLG_BENCH
+  // frame time must not include waiting for vblank in EndDrawing
+  SetConfigFlags(FLAG_WINDOW_UNDECORATED);
+#else
+  SetConfigFlags(FLAG_WINDOW_UNDECORATED | FLAG_VSYNC_HINT);
+#endif
+  InitWindow(di->width, di->heigth, "volumectl");
+  if (!IsWindowReady()) {
+    return -1;
+  }
+  SetWindowPosition(di->pos_x, di->pos_y);
+  return 0;
+}
+//////////////////////////////////////////////////////////////
+
+void dlg_backend_resize(const dlg_geometry_t *di) {
+  SetWindowSize(di->width, di->heigth);
+  SetWindowPosition(di->pos_x, di->pos_y);
+}
+//////////////////////////////////////////////////////////////
+
+void dlg_backend_close(void) { CloseWindow(); }
+//////////////////////////////////////////////////////////////
+
+void dlg_backend_input(dlg_input_t *in) {
+  in->should_close = WindowShouldClose();
+
+  Vector2 mp = GetMousePosition();
+  in->mouse_x = mp.x;
+  in->mouse_y = mp.y;
+  // MOUSE_BUTTON_LEFT = 0 and MU_MOUSE_LEFT = (1 << 0)
+  // MOUSE_BUTTON_RIGHT = 1 and MU_MOUSE_RIGHT = (1 << 1)
+  // MOUSE_BUTTON_MIDDLE = 2 and MU_MOUSE_MIDDLE = (1 << 2)
+  for (int btn = MOUSE_BUTTON_LEFT; btn <= MOUSE_BUTTON_MIDDLE; ++btn) {
+    if (IsMouseButtonDown(btn)) {
+      in->mouse_down |= 1 << btn;
+    }
+  }
+
+  const KeyboardKey keys_vol_up[] = {KEY_K, KEY_L, KEY_UP, KEY_RIGHT, KEY_NULL};
+  const KeyboardKey keys_vol_down[] = {KEY_J, KEY_H, KEY_DOWN, KEY_LEFT,
+                                       KEY_NULL};
+  for (const KeyboardKey *pk = keys_vol_up; *pk != KEY_NULL; ++pk) {
+    if (IsKeyPressed(*pk)) {
+      ++in->vol_delta;
+      break;
+    }
+  }
+  for (const KeyboardKey *pk = keys_vol_down; *pk != KEY_NULL; ++pk) {
+    if (IsKeyPressed(*pk)) {
+      --in->vol_delta;
+      break;
+    }
+  }
+}
+//////////////////////////////////////////////////////////////
+
+void dlg_backend_render(mu_Context *ctx) {
+  BeginDrawing();
+
+  mu_Command *cmd = NULL;
+  while (mu_next_command(ctx, &cmd)) {
+    switch (cmd->type) {
+    case MU_COMMAND_RECT: {
+      DrawRectangle(cmd->rect.rect.x, cmd->rect.rect.y, cmd->rect.rect.w,
+                    cmd->rect.rect.h, *(Color *)&cmd->rect.color);
+    } break;
+    case MU_COMMAND_TEXT: {
+      DrawText(cmd->text.str, cmd->text.pos.x, cmd->text.pos.y, FONT_SIZE,
+               *(Color *)&cmd->text.color);
+    } break;
+    } // switch (cmd->type)
+  } // while(mu_next_command(ctx, &cmd)
+
+  // actually we don't need it
+  Color rai_background = {.r = 0, .g = 0, .b = 0, .a = 0};
+  ClearBackground(rai_background);
+  EndDrawing();
+}
+//////////////////////////////////////////////////////////////
+
+int dlg_backend_text_width(const char *txt, int len) {
+  return MeasureText(TextFormat("%.*s", len, txt), FONT_SIZE);
+}
+//////////////////////////////////////////////////////////////
+
+int dlg_backend_text_height(void) { return FONT_SIZE; }
+//////////////////////////////////////////////////////////////
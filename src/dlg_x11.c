@@ -0,0 +1,440 @@
+#include "dlg_backend.h"
+#include "log.h"
+
+#include <microui.h>
+// bitmap font from microui demo, alpha texture + glyph rects
+#include "atlas.inl"
+
+#include <X11/XKBlib.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include <X11/keysym.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+// same as text_height in microui demo for this atlas
+#define FONT_HEIGHT 18
+
+static Display *g_dpy = NULL;
+static Window g_win = 0;
+static GC g_gc = 0;
+static Atom g_wm_delete = 0;
+
+static XImage *g_img = NULL;
+static XShmSegmentInfo g_shm = {0};
+static bool g_use_shm = false;
+static bool g_shm_failed = false;
+static mu_Rect g_clip = {0};
+
+static int g_mouse_x = 0, g_mouse_y = 0, g_mouse_down = 0;
+// keys are reported once per press, like raylib IsKeyPressed
+static uint32_t g_keys_held = 0;
+
+static const KeySym keys_vol_up[] = {XK_k, XK_l, XK_Up, XK_Right, NoSymbol};
+static const KeySym keys_vol_down[] = {XK_j, XK_h, XK_Down, XK_Left,
+                                       NoSymbol};
+
+static int img_create(int w, int h);
+static int img_create_shm(Visual *vis, int depth, int w, int h);
+static int shm_error_handler(Display *dpy, XErrorEvent *ev);
+static void img_destroy(void);
+static int key_bit(KeySym ks, int *dir);
+static void fill_rect(mu_Rect r, mu_Color c);
+static void draw_text(const char *txt, mu_Vec2 pos, mu_Color c);
+
+int img_create(int w, int h) {
+  int scr = DefaultScreen(g_dpy);
+  Visual *vis = DefaultVisual(g_dpy, scr);
+  int depth = DefaultDepth(g_dpy, scr);
+
+  // no MIT-SHM or it can't be used (e.g. remote display): same image, but
+  // sent with XPutImage
+  g_use_shm = XShmQueryExtension(g_dpy) && !img_create_shm(vis, depth, w, h);
+  if (!g_use_shm) {
+    char *data = calloc((size_t)w * h, 4);
+    if (!data) {
+      return -1;
+    }
+    g_img = XCreateImage(g_dpy, vis, depth, ZPixmap, 0, data, w, h, 32, 0);
+    if (!g_img) {
+      free(data);
+      return -1;
+    }
+  }
+
+  if (g_img->bits_per_pixel != 32) {
+    log_error("x11: unsupported bits per pixel: %d\n", g_img->bits_per_pixel);
+    img_destroy();
+    return -1;
+  }
+  return 0;
+}
+//////////////////////////////////////////////////////////////
+
+int img_create_shm(Visual *vis, int depth, int w, int h) {
+  g_img = XShmCreateImage(g_dpy, vis, depth, ZPixmap, NULL, &g_shm, w, h);
+  if (!g_img) {
+    return -1;
+  }
+  g_shm.shmid = shmget(IPC_PRIVATE, g_img->bytes_per_line * g_img->height,
+                       IPC_CREAT | 0600);
+  if (g_shm.shmid == -1) {
+    XDestroyImage(g_img);
+    g_img = NULL;
+    return -1;
+  }
+  g_shm.shmaddr = shmat(g_shm.shmid, NULL, 0);
+  // segment is destroyed after both sides detach
+  shmctl(g_shm.shmid, IPC_RMID, NULL);
+  if (g_shm.shmaddr == (char *)-1) {
+    XDestroyImage(g_img);
+    g_img = NULL;
+    memset(&g_shm, 0, sizeof(g_shm));
+    return -1;
+  }
+  g_img->data = g_shm.shmaddr;
+  g_shm.readOnly = False;
+
+  // server can refuse to attach (BadAccess when it can't see our segment),
+  // and default Xlib error handler would exit()
+  g_shm_failed = false;
+  int (*prev_handler)(Display *, XErrorEvent *) =
+      XSetErrorHandler(shm_error_handler);
+  XShmAttach(g_dpy, &g_shm);
+  XSync(g_dpy, False);
+  XSetErrorHandler(prev_handler);
+
+  if (g_shm_failed) {
+    log_error("x11: XShmAttach failed, %s\n", "falling back to XPutImage");
+    g_img->data = NULL; // owned by shm segment, not by XDestroyImage
+    XDestroyImage(g_img);
+    g_img = NULL;
+    shmdt(g_shm.shmaddr);
+    memset(&g_shm, 0, sizeof(g_shm));
+    return -1;
+  }
+  return 0;
+}
+//////////////////////////////////////////////////////////////
+
+int shm_error_handler(Display *dpy, XErrorEvent *ev) {
+  (void)dpy;
+  (void)ev;
+  g_shm_failed = true;
+  return 0;
+}
+//////////////////////////////////////////////////////////////
+
+void img_destroy(void) {
+  if (!g_img) {
+    return;
+  }
+
+  if (g_use_shm) {
+    XShmDetach(g_dpy, &g_shm);
+    XSync(g_dpy, False);
+    g_img->data = NULL; // owned by shm segment, not by XDestroyImage
+    XDestroyImage(g_img);
+    shmdt(g_shm.shmaddr);
+    memset(&g_shm, 0, sizeof(g_shm));
+  } else {
+    XDestroyImage(g_img); // frees data as well
+  }
+  g_img = NULL;
+}
+//////////////////////////////////////////////////////////////
+
+int key_bit(KeySym ks, int *dir) {
+  for (int i = 0; keys_vol_up[i] != NoSymbol; ++i) {
+    if (keys_vol_up[i] == ks) {
+      *dir = 1;
+      return i;
+    }
+  }
+  for (int i = 0; keys_vol_down[i] != NoSymbol; ++i) {
+    if (keys_vol_down[i] == ks) {
+      *dir = -1;
+      return 8 + i;
+    }
+  }
+  return -1;
+}
+//////////////////////////////////////////////////////////////
+
+static inline uint32_t blend(uint32_t dst, mu_Color c, int a) {
+  if (a >= 255) {
+    return (uint32_t)c.r << 16 | (uint32_t)c.g << 8 | c.b;
+  }
+  uint32_t r = (dst >> 16) & 0xff, g = (dst >> 8) & 0xff, b = dst & 0xff;
+  r = (c.r * a + r * (255 - a)) / 255;
+  g = (c.g * a + g * (255 - a)) / 255;
+  b = (c.b * a + b * (255 - a)) / 255;
+  return r << 16 | g << 8 | b;
+}
+
+void fill_rect(mu_Rect r, mu_Color c) {
+  int x0 = mu_max(r.x, g_clip.x), y0 = mu_max(r.y, g_clip.y);
+  int x1 = mu_min(r.x + r.w, g_clip.x + g_clip.w);
+  int y1 = mu_min(r.y + r.h, g_clip.y + g_clip.h);
+  for (int y = y0; y < y1; ++y) {
+    uint32_t *row = (uint32_t *)(g_img->data + y * g_img->bytes_per_line);
+    for (int x = x0; x < x1; ++x) {
+      row[x] = blend(row[x], c, c.a);
+    }
+  }
+}
+//////////////////////////////////////////////////////////////
+
+void draw_text(const char *txt, mu_Vec2 pos, mu_Color c) {
+  int dx = pos.x;
+  for (const char *p = txt; *p; ++p) {
+    if ((*p & 0xc0) == 0x80) {
+      continue; // utf-8 continuation byte
+    }
+    int chr = mu_min((unsigned char)*p, 127);
+    mu_Rect src = atlas[ATLAS_FONT + chr];
+
+    int x0 = mu_max(dx, g_clip.x), y0 = mu_max(pos.y, g_clip.y);
+    int x1 = mu_min(dx + src.w, g_clip.x + g_clip.w);
+    int y1 = mu_min(pos.y + src.h, g_clip.y + g_clip.h);
+    for (int y = y0; y < y1; ++y) {
+      uint32_t *row = (uint32_t *)(g_img->data + y * g_img->bytes_per_line);
+      int glyph_row = (src.y + y - pos.y) * ATLAS_WIDTH + src.x;
+      for (int x = x0; x < x1; ++x) {
+        int a = atlas_texture[glyph_row + (x - dx)] * c.a / 255;
+        if (a) {
+          row[x] = blend(row[x], c, a);
+        }
+      }
+    }
+    dx += src.w;
+  }
+}
+//////////////////////////////////////////////////////////////
+
+const char *dlg_backend_name(void) { return "x11"; }
+//////////////////////////////////////////////////////////////
+
+int dlg_backend_open(const dlg_geometry_t *di) {
+  g_dpy = XOpenDisplay(NULL);
+  if (!g_dpy) {
+    log_error("x11: can't open display %s\n", XDisplayName(NULL));
+    return -1;
+  }
+
+  int scr = DefaultScreen(g_dpy);
+  Visual *vis = DefaultVisual(g_dpy, scr);
+  // rasterizer writes 32-bit xRGB pixels only, see README
+  if (vis->red_mask != 0xff0000 || vis->green_mask != 0xff00 ||
+      vis->blue_mask != 0xff) {
+    log_error("x11: unsupported visual, depth %d\n", DefaultDepth(g_dpy, scr));
+    XCloseDisplay(g_dpy);
+    g_dpy = NULL;
+    return -1;
+  }
+
+  XSetWindowAttributes swa = {
+      .background_pixel = BlackPixel(g_dpy, scr),
+      .event_mask = ExposureMask | StructureNotifyMask | KeyPressMask |
+                    KeyReleaseMask | ButtonPressMask | ButtonReleaseMask |
+                    PointerMotionMask,
+  };
+  g_win = XCreateWindow(g_dpy, RootWindow(g_dpy, scr), di->pos_x, di->pos_y,
+                        di->width, di->heigth, 0, DefaultDepth(g_dpy, scr),
+                        InputOutput, vis, CWBackPixel | CWEventMask, &swa);
+  XStoreName(g_dpy, g_win, "volumectl");
+
+  // undecorated, same as FLAG_WINDOW_UNDECORATED in raylib (motif hints)
+  struct {
+    unsigned long flags, functions, decorations;
+    long input_mode;
+    unsigned long status;
+  } mwm = {.flags = 1L << 1, .decorations = 0};
+  Atom mwm_atom = XInternAtom(g_dpy, "_MOTIF_WM_HINTS", False);
+  XChangeProperty(g_dpy, g_win, mwm_atom, mwm_atom, 32, PropModeReplace,
+                  (unsigned char *)&mwm, 5);
+
+  XSizeHints sh = {.flags = USPosition | USSize,
+                   .x = di->pos_x,
+                   .y = di->pos_y,
+                   .width = di->width,
+                   .height = di->heigth};
+  XSetWMNormalHints(g_dpy, g_win, &sh);
+
+  g_wm_delete = XInternAtom(g_dpy, "WM_DELETE_WINDOW", False);
+  XSetWMProtocols(g_dpy, g_win, &g_wm_delete, 1);
+  // otherwise held key produces release/press pairs
+  XkbSetDetectableAutoRepeat(g_dpy, True, NULL);
+
+  g_gc = XCreateGC(g_dpy, g_win, 0, NULL);
+  if (img_create(di->width, di->heigth)) {
+    log_error("x11: can't create %dx%d image\n", di->width, di->heigth);
+    dlg_backend_close();
+    return -1;
+  }
+
+  XMapWindow(g_dpy, g_win);
+  XMoveWindow(g_dpy, g_win, di->pos_x, di->pos_y);
+  // raylib returns from InitWindow with the window already mapped, so wait
+  // for it here as well, otherwise open time doesn't include the map
+  XEvent ev;
+  do {
+    XWindowEvent(g_dpy, g_win, StructureNotifyMask, &ev);
+  } while (ev.type != MapNotify);
+
+  g_mouse_x = g_mouse_y = g_mouse_down = 0;
+  g_keys_held = 0;
+  return 0;
+}
+//////////////////////////////////////////////////////////////
+
+void dlg_backend_resize(const dlg_geometry_t *di) {
+  img_destroy();
+  XMoveResizeWindow(g_dpy, g_win, di->pos_x, di->pos_y, di->width,
+                    di->heigth);
+  if (img_create(di->width, di->heigth)) {
+    log_error("x11: can't recreate %dx%d image\n", di->width, di->heigth);
+  }
+}
+//////////////////////////////////////////////////////////////
+
+void dlg_backend_close(void) {
+  if (!g_dpy) {
+    return;
+  }
+  img_destroy();
+  if (g_gc) {
+    XFreeGC(g_dpy, g_gc);
+    g_gc = 0;
+  }
+  XDestroyWindow(g_dpy, g_win);
+  g_win = 0;
+  XCloseDisplay(g_dpy);
+  g_dpy = NULL;
+}
+//////////////////////////////////////////////////////////////
+
+void dlg_backend_input(dlg_input_t *in) {
+  bool up = false, down = false;
+  int dir, bit;
+  KeySym ks;
+
+  while (XPending(g_dpy)) {
+    XEvent ev;
+    XNextEvent(g_dpy, &ev);
+    switch (ev.type) {
+    case MotionNotify:
+      g_mouse_x = ev.xmotion.x;
+      g_mouse_y = ev.xmotion.y;
+      break;
+    case ButtonPress:
+    case ButtonRelease: {
+      // Button1 - left, Button2 - middle, Button3 - right
+      int btn = ev.xbutton.button == Button1   ? MU_MOUSE_LEFT
+                : ev.xbutton.button == Button2 ? MU_MOUSE_MIDDLE
+                : ev.xbutton.button == Button3 ? MU_MOUSE_RIGHT
+                                               : 0;
+      g_mouse_x = ev.xbutton.x;
+      g_mouse_y = ev.xbutton.y;
+      if (ev.type == ButtonPress) {
+        g_mouse_down |= btn;
+      } else {
+        g_mouse_down &= ~btn;
+      }
+    } break;
+    case KeyPress:
+      ks = XLookupKeysym(&ev.xkey, 0);
+      if (ks == XK_Escape) {
+        in->should_close = true; // raylib default exit key
+        break;
+      }
+      bit = key_bit(ks, &dir);
+      if (bit < 0 || (g_keys_held & (1u << bit))) {
+        break;
+      }
+      g_keys_held |= 1u << bit;
+      up |= dir > 0;
+      down |= dir < 0;
+      break;
+    case KeyRelease:
+      bit = key_bit(XLookupKeysym(&ev.xkey, 0), &dir);
+      if (bit >= 0) {
+        g_keys_held &= ~(1u << bit);
+      }
+      break;
+    case ClientMessage:
+      if ((Atom)ev.xclient.data.l[0] == g_wm_delete) {
+        in->should_close = true;
+      }
+      break;
+    default:
+      break; // Expose, ConfigureNotify etc.: we redraw every frame anyway
+    }
+  }
+
+  in->mouse_x = g_mouse_x;
+  in->mouse_y = g_mouse_y;
+  in->mouse_down = g_mouse_down;
+  in->vol_delta = up - down;
+}
+//////////////////////////////////////////////////////////////
+
+void dlg_backend_render(mu_Context *ctx) {
+  if (!g_img) {
+    return;
+  }
+
+  mu_Rect full = mu_rect(0, 0, g_img->width, g_img->height);
+  memset(g_img->data, 0, (size_t)g_img->bytes_per_line * g_img->height);
+  g_clip = full;
+
+  mu_Command *cmd = NULL;
+  while (mu_next_command(ctx, &cmd)) {
+    switch (cmd->type) {
+    case MU_COMMAND_RECT: {
+      fill_rect(cmd->rect.rect, cmd->rect.color);
+    } break;
+    case MU_COMMAND_TEXT: {
+      draw_text(cmd->text.str, cmd->text.pos, cmd->text.color);
+    } break;
+    case MU_COMMAND_CLIP: {
+      mu_Rect r = cmd->clip.rect;
+      int x0 = mu_max(r.x, 0), y0 = mu_max(r.y, 0);
+      int x1 = mu_min(r.x + r.w, full.w), y1 = mu_min(r.y + r.h, full.h);
+      g_clip = mu_rect(x0, y0, mu_max(x1 - x0, 0), mu_max(y1 - y0, 0));
+    } break;
+    } // switch (cmd->type)
+  } // while(mu_next_command(ctx, &cmd)
+
+  if (g_use_shm) {
+    XShmPutImage(g_dpy, g_win, g_gc, g_img, 0, 0, 0, 0, g_img->width,
+                 g_img->height, False);
+  } else {
+    XPutImage(g_dpy, g_win, g_gc, g_img, 0, 0, 0, 0, g_img->width,
+              g_img->height);
+  }
+  // image memory is reused next frame, so wait till server has it
+  XSync(g_dpy, False);
+}
+//////////////////////////////////////////////////////////////
+
+int dlg_backend_text_width(const char *txt, int len) {
+  int res = 0;
+  for (const char *p = txt; *p && len--; ++p) {
+    if ((*p & 0xc0) == 0x80) {
+      continue;
+    }
+    int chr = mu_min((unsigned char)*p, 127);
+    res += atlas[ATLAS_FONT + chr].w;
+  }
+  return res;
+}
+//////////////////////////////////////////////////////////////
+
+int dlg_backend_text_height(void) { return FONT_HEIGHT; }
+//////////////////////////////////////////////////////////////
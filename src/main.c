@@ -1,6 +1,7 @@
 #include "dlg.h"
 #include "log.h"
 #include "out.h"
+#include "streams.h"
 #include "sys.h"
 
 #include <cjson/cJSON.h>
@@ -23,30 +24,67 @@ static int64_t g_curr_vol = 0;
 
 static uint32_t g_current_sink_idx = 0;
 static uint8_t g_current_sink_channels = 0;
+// sink index is not stable across server restarts, writes wait for fresh info
+static bool g_current_sink_known = false;
+
+// context is rebuilt on failure, so it lives here and not in main
+static pa_context *g_pa_ctx = NULL;
+static pa_time_event *g_reconnect_ev = NULL;
+#define RECONNECT_DELAY_MIN (100 * PA_USEC_PER_MSEC)
+#define RECONNECT_DELAY_MAX (10 * PA_USEC_PER_SEC)
+static pa_usec_t g_reconnect_delay = RECONNECT_DELAY_MIN;
 
 typedef struct click_info {
   int x, y, rel_x, rel_y, blk_w, blk_h;
 } click_info_t;
 
+// last click, dialog geometry is recalculated from it when stream list changes
+static click_info_t g_last_ci = {0};
+static size_t g_dlg_streams = 0;
+
+// event path timings, printed on exit next to dlg ones. handler work only:
+// no trace logging and no dialog open (that one is measured by dlg)
+typedef struct ev_timing {
+  uint64_t usec;
+  uint32_t n;
+} ev_timing_t;
+static ev_timing_t g_tm_sink = {0};
+static ev_timing_t g_tm_sink_input = {0};
+static ev_timing_t g_tm_click = {0};
+
 static int parse_click_info_json(const char *json, click_info_t *out);
 static int line_getc(int fd, char *c);
 static ssize_t line_gets(int fd, char *buf, size_t size);
 static void die(const char *msg);
+static void ev_timing_add(ev_timing_t *tm, uint64_t t0);
+static double ev_timing_avg(const ev_timing_t *tm);
 static void pa_exit_signal_cb(pa_mainloop_api *api, pa_signal_event *e, int sig,
                               void *userdata);
 static void pa_io_event_cb(pa_mainloop_api *ea, pa_io_event *e, int fd,
                            pa_io_event_flags_t events, void *userdata);
+static void dlg_geometry_from_click(const click_info_t *ci, size_t n_streams,
+                                    dlg_geometry_t *out);
+static int64_t cvolume_to_percent(const pa_cvolume *cv);
 static void pa_sink_info_cb(pa_context *c, const pa_sink_info *i, int eol,
                             void *userdata);
+static void pa_sink_input_info_cb(pa_context *c, const pa_sink_input_info *i,
+                                  int eol, void *userdata);
 static void ctx_on_change_cb(pa_context *c, pa_subscription_event_type_t t,
                              uint32_t idx, void *userdata);
 static void subscribe_success_cb(pa_context *c, int success, void *userdata);
 static void ctx_state_changed_cb(pa_context *pa_ctx, void *userdata);
+static bool ctx_is_ready(void);
+static int ctx_connect(pa_mainloop_api *api);
+static void ctx_schedule_reconnect(pa_mainloop_api *api);
+static void ctx_reconnect_cb(pa_mainloop_api *api, pa_time_event *e,
+                             const struct timeval *tv, void *userdata);
 static void set_sink_vol_status_cb(pa_context *c, int success, void *userdata);
 static void set_sink_volume_by_idx_and_channels(pa_context *c, uint32_t idx,
                                                 uint8_t channels);
 static void set_sink_volume_cb(pa_context *c, const pa_sink_info *i, int eol,
                                void *userdata);
+static void set_sink_input_volume(pa_context *c, const stream_t *s,
+                                  int32_t vol);
 
 int parse_click_info_json(const char *json, click_info_t *out) {
   if (!json || !out)
@@ -98,6 +136,17 @@ void die(const char *msg) {
 }
 //////////////////////////////////////////////////////////////
 
+void ev_timing_add(ev_timing_t *tm, uint64_t t0) {
+  tm->usec += sys_now_usec() - t0;
+  ++tm->n;
+}
+//////////////////////////////////////////////////////////////
+
+double ev_timing_avg(const ev_timing_t *tm) {
+  return tm->n ? (double)tm->usec / tm->n : 0.0;
+}
+//////////////////////////////////////////////////////////////
+
 void pa_exit_signal_cb(pa_mainloop_api *api, pa_signal_event *e, int sig,
                        void *userdata) {
   log_trace("Got exit signal %d\n", sig);
@@ -112,6 +161,7 @@ void pa_io_event_cb(pa_mainloop_api *ea, pa_io_event *e, int fd,
     return; // we expect input only from stdin
   }
 
+  uint64_t t0 = sys_now_usec();
   int rc;
   char buff[1024] = {0};
   rc = line_gets(STDIN_FILENO, buff, sizeof(buff) - 1);
@@ -125,15 +175,17 @@ void pa_io_event_cb(pa_mainloop_api *ea, pa_io_event *e, int fd,
     log_error("[stdin] INVALID JSON: %zd bytes: %s\n", strlen(buff), buff);
     return;
   }
+  ev_timing_add(&g_tm_click, t0);
 
-  // if panel on top - positive offset. else - negative offset (offset =
-  // block.height)
-  int32_t coeff = ci.y - ci.rel_y == 0 ? 1 : -1;
-  dlg_geometry_t di = {.width = ci.blk_w + 150,
-                       .heigth = ci.blk_h, // (same as block)
-                       .pos_x = ci.x - ci.rel_x - ci.blk_w / 2,
-                       .pos_y = ci.y - ci.rel_y + ci.blk_h * coeff};
-  dlg_open(g_curr_vol, &di);
+  // a click while the dialog is open doesn't move it, so keep geometry
+  // inputs of the open dialog as they are
+  if (!dlg_is_open()) {
+    g_last_ci = ci;
+    g_dlg_streams = streams_count();
+    dlg_geometry_t di = {0};
+    dlg_geometry_from_click(&ci, g_dlg_streams, &di);
+    dlg_open(g_curr_vol, &di);
+  }
 
   log_trace("[stdin] click_info:\n");
   log_trace("\tx: %d\n", ci.x);
@@ -145,27 +197,56 @@ void pa_io_event_cb(pa_mainloop_api *ea, pa_io_event *e, int fd,
 }
 //////////////////////////////////////////////////////////////
 
+void dlg_geometry_from_click(const click_info_t *ci, size_t n_streams,
+                             dlg_geometry_t *out) {
+  // one block-height row for sink and one per stream
+  int32_t rows = 1 + (int32_t)n_streams;
+  int32_t extra_w =
+      n_streams ? DLG_STREAM_LABEL_WIDTH - DLG_SINK_LABEL_WIDTH : 0;
+  // if panel on top - positive offset. else - negative offset (offset =
+  // dialog height)
+  bool on_top = ci->y - ci->rel_y == 0;
+  out->width = ci->blk_w + 150 + extra_w;
+  out->heigth = ci->blk_h * rows;
+  out->pos_x = ci->x - ci->rel_x - ci->blk_w / 2;
+  out->pos_y = ci->y - ci->rel_y + (on_top ? ci->blk_h : -out->heigth);
+}
+//////////////////////////////////////////////////////////////
+
+int64_t cvolume_to_percent(const pa_cvolume *cv) {
+  // we want just first channel actually, but let's do in a "right" way
+  uint64_t v = 0;
+  if (cv->channels == 0) {
+    return 0;
+  }
+  for (uint8_t ci = 0; ci < cv->channels; ++ci) {
+    v += (cv->values[ci] * 100 + PA_VOLUME_NORM / 2) / PA_VOLUME_NORM;
+  }
+  v /= cv->channels;
+  return (int64_t)v;
+}
+//////////////////////////////////////////////////////////////
+
 void pa_sink_info_cb(pa_context *c, const pa_sink_info *i, int eol,
                      void *userdata) {
   if (i == NULL) {
     return; // probably impossible
   }
 
+  uint64_t t0 = sys_now_usec();
   g_current_sink_idx = i->index;
   g_current_sink_channels = i->channel_map.channels;
+  g_current_sink_known = true;
+  streams_set_sink(i->index);
 
-  // we want just first channel actually, but let's do in a "right" way
-  uint64_t v = 0;
-  for (uint8_t ci = 0; ci < i->volume.channels; ++ci) {
-    v += (i->volume.values[ci] * 100 + PA_VOLUME_NORM / 2) / PA_VOLUME_NORM;
-  }
-  v /= i->volume.channels;
+  uint64_t v = (uint64_t)cvolume_to_percent(&i->volume);
   g_curr_vol = (int64_t)v;
 
   // questionable. but if dlg_is_open we use optimistic update in main
   if (!dlg_is_open()) {
     volume_to_stdout(v, !!i->mute);
   }
+  ev_timing_add(&g_tm_sink, t0);
 
   log_trace("Sink #%u\n", i->index);
   log_trace("\tName: %s\n", i->name);
@@ -187,6 +268,45 @@ void pa_sink_info_cb(pa_context *c, const pa_sink_info *i, int eol,
 }
 //////////////////////////////////////////////////////////////
 
+void pa_sink_input_info_cb(pa_context *c, const pa_sink_input_info *i,
+                           int eol, void *userdata) {
+  (void)c;
+  (void)eol;
+  (void)userdata;
+  if (i == NULL) {
+    return; // eol of list or stream has gone already
+  }
+
+  uint64_t t0 = sys_now_usec();
+  bool is_new = streams_get(i->index) == NULL;
+  stream_t *s = streams_put(i->index);
+  if (!s) {
+    log_error("stream cache is full, sink input #%u ignored\n", i->index);
+    return;
+  }
+
+  const char *name = pa_proplist_gets(i->proplist, PA_PROP_APPLICATION_NAME);
+  if (!name) {
+    name = i->name ? i->name : "?";
+  }
+  snprintf(s->name, sizeof(s->name), "%s", name);
+  s->sink_idx = i->sink;
+  s->channels = i->channel_map.channels;
+  s->vol = (int32_t)cvolume_to_percent(&i->volume);
+  // while dialog is open its slider wins, same as for sink slider
+  if (is_new || !dlg_is_open()) {
+    s->slider = (float)s->vol;
+  }
+  ev_timing_add(&g_tm_sink_input, t0);
+
+  log_trace("Sink input #%u\n", i->index);
+  log_trace("\tName: %s\n", s->name);
+  log_trace("\tSink: %u\n", i->sink);
+  log_trace("\tVolume: %d%%\n", s->vol);
+  log_trace("%s\n", "----------------------------------------");
+}
+//////////////////////////////////////////////////////////////
+
 void ctx_on_change_cb(pa_context *c, pa_subscription_event_type_t t,
                       uint32_t idx, void *userdata) {
   pa_subscription_event_type_t facility =
@@ -211,13 +331,29 @@ void ctx_on_change_cb(pa_context *c, pa_subscription_event_type_t t,
       }
     }
   } // if (facility == PA_SUBSCRIPTION_EVENT_SINK)
+
+  if (facility == PA_SUBSCRIPTION_EVENT_SINK_INPUT) {
+    if (op == PA_SUBSCRIPTION_EVENT_REMOVE) {
+      streams_remove(idx);
+      return;
+    }
+    // NEW and CHANGE: refresh just this one entry of the cache
+    pa_operation *pop = pa_context_get_sink_input_info(
+        c, idx, pa_sink_input_info_cb, userdata);
+    if (pop) {
+      pa_operation_unref(pop);
+    }
+  } // if (facility == PA_SUBSCRIPTION_EVENT_SINK_INPUT)
 }
 //////////////////////////////////////////////////////////////
 
 void subscribe_success_cb(pa_context *c, int success, void *userdata) {
   log_trace("subscribe_success_cb succes = %d\n", success);
   if (!success) {
-    die("subscribe_ctx_cb");
+    // same as context failure: server probably has gone mid-handshake
+    log_error("subscribe_success_cb: %s\n", pa_strerror(pa_context_errno(c)));
+    ctx_schedule_reconnect((pa_mainloop_api *)userdata);
+    return;
   }
   pa_context_set_subscribe_callback(c, ctx_on_change_cb, NULL);
 }
@@ -228,25 +364,109 @@ void ctx_state_changed_cb(pa_context *pa_ctx, void *userdata) {
   log_trace("pa_context_notify_cb: state = %x\n", state);
 
   if (!PA_CONTEXT_IS_GOOD(state)) {
-    // todo restore it somehow, restart everything
-    // etc., instead of die
-    die("PA_CONTEXT IS NOT GOOD\n");
+    // server has gone. cached sink state and last status line stay as is,
+    // context is rebuilt later from the mainloop, not from its own callback.
+    // stream indices are not stable across server restarts, so drop them
+    // now: an open dialog shrinks to the sink row on the next tick
+    log_error("PA_CONTEXT IS NOT GOOD: %s\n",
+              pa_strerror(pa_context_errno(pa_ctx)));
+    g_current_sink_known = false;
+    streams_clear();
+    ctx_schedule_reconnect((pa_mainloop_api *)userdata);
+    return;
   }
 
   if (state == PA_CONTEXT_READY) {
+    g_reconnect_delay = RECONNECT_DELAY_MIN;
+
     pa_operation *init_op =
         pa_context_get_sink_info_by_name(pa_ctx, NULL, pa_sink_info_cb, NULL);
     if (init_op) {
       pa_operation_unref(init_op);
     }
 
-    pa_subscription_mask_t ctx_sub_msk = PA_SUBSCRIPTION_MASK_SINK;
+    pa_subscription_mask_t ctx_sub_msk =
+        PA_SUBSCRIPTION_MASK_SINK | PA_SUBSCRIPTION_MASK_SINK_INPUT;
     pa_operation *op =
-        pa_context_subscribe(pa_ctx, ctx_sub_msk, subscribe_success_cb, NULL);
+        pa_context_subscribe(pa_ctx, ctx_sub_msk, subscribe_success_cb, userdata);
     log_debug("pa_op: %p\n", op);
     if (op) {
       pa_operation_unref(op);
     }
+
+    // whole list only once, after that cache is updated by events.
+    // requested after subscribe, so no stream falls between the two
+    pa_operation *list_op = pa_context_get_sink_input_info_list(
+        pa_ctx, pa_sink_input_info_cb, NULL);
+    if (list_op) {
+      pa_operation_unref(list_op);
+    }
+  }
+}
+//////////////////////////////////////////////////////////////
+
+bool ctx_is_ready(void) {
+  return g_pa_ctx && pa_context_get_state(g_pa_ctx) == PA_CONTEXT_READY;
+}
+//////////////////////////////////////////////////////////////
+
+int ctx_connect(pa_mainloop_api *api) {
+  g_pa_ctx = pa_context_new(api, "volumectl");
+  if (!g_pa_ctx) {
+    return -1;
+  }
+
+  pa_context_set_state_callback(g_pa_ctx, ctx_state_changed_cb, api);
+  if (pa_context_connect(g_pa_ctx, NULL, PA_CONTEXT_NOFLAGS, NULL) < 0) {
+    log_error("pa_context_connect: %s\n",
+              pa_strerror(pa_context_errno(g_pa_ctx)));
+    return -1;
+  }
+  return 0;
+}
+//////////////////////////////////////////////////////////////
+
+void ctx_schedule_reconnect(pa_mainloop_api *api) {
+  if (g_reconnect_ev) {
+    return; // already scheduled
+  }
+
+  struct timeval tv;
+  pa_gettimeofday(&tv);
+  pa_timeval_add(&tv, g_reconnect_delay);
+  log_trace("reconnect in %llu ms\n",
+            (unsigned long long)(g_reconnect_delay / PA_USEC_PER_MSEC));
+
+  g_reconnect_ev = api->time_new(api, &tv, ctx_reconnect_cb, NULL);
+  if (!g_reconnect_ev) {
+    die("time_new\n");
+  }
+
+  // bounded exponential backoff, reset when context becomes ready
+  g_reconnect_delay *= 2;
+  if (g_reconnect_delay > RECONNECT_DELAY_MAX) {
+    g_reconnect_delay = RECONNECT_DELAY_MAX;
+  }
+}
+//////////////////////////////////////////////////////////////
+
+void ctx_reconnect_cb(pa_mainloop_api *api, pa_time_event *e,
+                      const struct timeval *tv, void *userdata) {
+  (void)tv;
+  (void)userdata;
+  api->time_free(e);
+  g_reconnect_ev = NULL;
+
+  if (g_pa_ctx) {
+    pa_context_set_state_callback(g_pa_ctx, NULL, NULL);
+    pa_context_disconnect(g_pa_ctx);
+    pa_context_unref(g_pa_ctx);
+    g_pa_ctx = NULL;
+  }
+
+  log_trace("%s\n", "reconnecting");
+  if (ctx_connect(api)) {
+    ctx_schedule_reconnect(api);
   }
 }
 //////////////////////////////////////////////////////////////
@@ -284,6 +504,19 @@ void set_sink_volume_cb(pa_context *c, const pa_sink_info *i, int eol,
 }
 //////////////////////////////////////////////////////////////
 
+void set_sink_input_volume(pa_context *c, const stream_t *s, int32_t vol) {
+  pa_cvolume cv;
+  double d_vol = vol / 100.0;
+  pa_volume_t v = llround(d_vol * PA_VOLUME_NORM);
+  pa_cvolume_set(&cv, s->channels, v);
+  pa_operation *op = pa_context_set_sink_input_volume(
+      c, s->idx, &cv, set_sink_vol_status_cb, NULL);
+  if (op) {
+    pa_operation_unref(op);
+  }
+}
+//////////////////////////////////////////////////////////////
+
 int main(int argc, char *argv[], char **env) {
   (void)argc;
   (void)argv;
@@ -315,9 +548,10 @@ int main(int argc, char *argv[], char **env) {
     }
   }
 
-  pa_context *pa_ctx = pa_context_new(pa_api, "volumectl");
-  rc = pa_context_connect(pa_ctx, NULL, PA_CONTEXT_NOFLAGS, NULL);
-  pa_context_set_state_callback(pa_ctx, ctx_state_changed_cb, NULL);
+  if (ctx_connect(pa_api)) {
+    // no server yet, keep trying in background
+    ctx_schedule_reconnect(pa_api);
+  }
   pa_io_event *pa_ioev = pa_api->io_new(pa_api, STDIN_FILENO, PA_IO_EVENT_INPUT,
                                         pa_io_event_cb, NULL);
 
@@ -327,6 +561,10 @@ int main(int argc, char *argv[], char **env) {
   while (g_running && (pa_mainloop_iterate(pa_ml, 0, &rc) >= 0)) {
     if (dlg_is_open()) {
       dlg_tick();
+    }
+    // while reconnecting dialog keeps working, writes wait for new context
+    // and for default sink info from it
+    if (dlg_is_open() && ctx_is_ready() && g_current_sink_known) {
       int64_t dlg_vol = dlg_current_vol();
       if (dlg_vol != g_curr_vol) {
         // Performance HACK!
@@ -336,17 +574,48 @@ int main(int argc, char *argv[], char **env) {
         // (pa_context_get_sink_info_by_index -> set_sink_volume_cb) This makes
         // update in i3block panel MUCH faster
         volume_to_stdout(dlg_vol, dlg_vol == 0);
-        set_sink_volume_by_idx_and_channels(pa_ctx, g_current_sink_idx,
+        set_sink_volume_by_idx_and_channels(g_pa_ctx, g_current_sink_idx,
                                             g_current_sink_channels);
         g_curr_vol = dlg_vol;
       }
+
+      // same rule as for sink: at most one write per stream per frame and
+      // only if slider value differs from the last known one
+      for (stream_t *s = streams_next(NULL); s; s = streams_next(s)) {
+        int32_t sv = (int32_t)s->slider;
+        if (sv == s->vol) {
+          continue;
+        }
+        set_sink_input_volume(g_pa_ctx, s, sv);
+        s->vol = sv;
+      }
+    }
+
+    if (dlg_is_open() && streams_count() != g_dlg_streams) {
+      dlg_geometry_t di = {0};
+      g_dlg_streams = streams_count();
+      dlg_geometry_from_click(&g_last_ci, g_dlg_streams, &di);
+      dlg_resize(&di);
     }
     nanosleep(&ts_sleep_between_frames, NULL);
   }
 
+  dlg_close();
+  log_trace("events: sink %u avg %.3f us, sink-input %u avg %.3f us, "
+            "click %u avg %.3f us\n",
+            g_tm_sink.n, ev_timing_avg(&g_tm_sink), g_tm_sink_input.n,
+            ev_timing_avg(&g_tm_sink_input), g_tm_click.n,
+            ev_timing_avg(&g_tm_click));
   log_trace("pa_mainloop_free\n");
   pa_api->io_free(pa_ioev);
-  pa_context_unref(pa_ctx);
+  if (g_reconnect_ev) {
+    pa_api->time_free(g_reconnect_ev);
+  }
+  if (g_pa_ctx) {
+    pa_context_set_state_callback(g_pa_ctx, NULL, NULL);
+    pa_context_disconnect(g_pa_ctx);
+    pa_context_unref(g_pa_ctx);
+  }
   pa_mainloop_free(pa_ml);
   return 0;
 }
@@ -0,0 +1,71 @@
+#include "streams.h"
+
+#include <string.h>
+
+// fixed slots, so pointers stay valid while dialog uses them as microui ids
+static stream_t g_streams[STREAMS_MAX] = {0};
+static uint32_t g_sink_idx = 0;
+
+stream_t *streams_get(uint32_t idx) {
+  for (size_t i = 0; i < STREAMS_MAX; ++i) {
+    if (g_streams[i].used && g_streams[i].idx == idx) {
+      return &g_streams[i];
+    }
+  }
+  return NULL;
+}
+//////////////////////////////////////////////////////////////
+
+stream_t *streams_put(uint32_t idx) {
+  stream_t *s = streams_get(idx);
+  if (s) {
+    return s;
+  }
+
+  for (size_t i = 0; i < STREAMS_MAX; ++i) {
+    if (g_streams[i].used) {
+      continue;
+    }
+    s = &g_streams[i];
+    memset(s, 0, sizeof(*s));
+    s->used = true;
+    s->idx = idx;
+    return s;
+  }
+  return NULL; // cache is full
+}
+//////////////////////////////////////////////////////////////
+
+void streams_remove(uint32_t idx) {
+  stream_t *s = streams_get(idx);
+  if (s) {
+    s->used = false;
+  }
+}
+//////////////////////////////////////////////////////////////
+
+void streams_clear(void) { memset(g_streams, 0, sizeof(g_streams)); }
+//////////////////////////////////////////////////////////////
+
+void streams_set_sink(uint32_t sink_idx) { g_sink_idx = sink_idx; }
+//////////////////////////////////////////////////////////////
+
+size_t streams_count(void) {
+  size_t n = 0;
+  for (stream_t *s = streams_next(NULL); s; s = streams_next(s)) {
+    ++n;
+  }
+  return n;
+}
+//////////////////////////////////////////////////////////////
+
+stream_t *streams_next(stream_t *it) {
+  stream_t *end = g_streams + STREAMS_MAX;
+  for (stream_t *s = it ? it + 1 : g_streams; s < end; ++s) {
+    if (s->used && s->sink_idx == g_sink_idx) {
+      return s;
+    }
+  }
+  return NULL;
+}
+//////////////////////////////////////////////////////////////
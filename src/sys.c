@@ -1,5 +1,6 @@
 #include <errno.h>
 #include <fcntl.h>
+#include <time.h>
 
 #include <sys/stat.h>
 #include <sys/time.h>
@@ -68,3 +69,10 @@ int sys_cloexec(int fd) {
   return sys_setfd(fd, flags | FD_CLOEXEC);
 }
 //////////////////////////////////////////////////////////////
+
+uint64_t sys_now_usec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+//////////////////////////////////////////////////////////////